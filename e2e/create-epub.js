@@ -35,8 +35,11 @@ function toBytes(str) {
 /**
  * Create a ZIP file from an array of { name, data, store } entries.
  * If store is true, the entry is stored uncompressed (required for mimetype).
+ * With opts.zip64, sizes, offsets and counts are written as ZIP64 records
+ * (extra fields, ZIP64 end record and locator) behind 0xFFFF... markers.
  */
-function createZip(entries) {
+function createZip(entries, opts = {}) {
+  const zip64 = opts.zip64 || false;
   const localHeaders = [];
   const centralEntries = [];
   let offset = 0;
@@ -74,8 +77,9 @@ function createZip(entries) {
     nameBytes.copy(local, 30);
     compressedData.copy(local, 30 + nameBytes.length);
 
-    // Central directory entry (46 bytes + name)
-    const central = Buffer.alloc(46 + nameBytes.length);
+    // Central directory entry (46 bytes + name [+ ZIP64 extra field])
+    const extraLen = zip64 ? 28 : 0;
+    const central = Buffer.alloc(46 + nameBytes.length + extraLen);
     central.writeUInt32LE(0x02014B50, 0);  // signature
     central.writeUInt16LE(20, 4);          // version made by
     central.writeUInt16LE(20, 6);          // version needed
@@ -84,16 +88,24 @@ function createZip(entries) {
     central.writeUInt16LE(0, 12);          // mod time
     central.writeUInt16LE(0, 14);          // mod date
     central.writeUInt32LE(crc, 16);        // crc-32
-    central.writeUInt32LE(compressedSize, 20);
-    central.writeUInt32LE(uncompressedSize, 24);
+    central.writeUInt32LE(zip64 ? 0xFFFFFFFF : compressedSize, 20);
+    central.writeUInt32LE(zip64 ? 0xFFFFFFFF : uncompressedSize, 24);
     central.writeUInt16LE(nameBytes.length, 28);
-    central.writeUInt16LE(0, 30);          // extra field length
+    central.writeUInt16LE(extraLen, 30);   // extra field length
     central.writeUInt16LE(0, 32);          // comment length
     central.writeUInt16LE(0, 34);          // disk number start
     central.writeUInt16LE(0, 36);          // internal attrs
     central.writeUInt32LE(0, 38);          // external attrs
-    central.writeUInt32LE(offset, 42);     // local header offset
+    central.writeUInt32LE(zip64 ? 0xFFFFFFFF : offset, 42); // local header offset
     nameBytes.copy(central, 46);
+    if (zip64) {
+      const x = 46 + nameBytes.length;
+      central.writeUInt16LE(0x0001, x);    // ZIP64 extended information
+      central.writeUInt16LE(24, x + 2);
+      central.writeBigUInt64LE(BigInt(uncompressedSize), x + 4);
+      central.writeBigUInt64LE(BigInt(compressedSize), x + 12);
+      central.writeBigUInt64LE(BigInt(offset), x + 20);
+    }
 
     localHeaders.push(local);
     centralEntries.push(central);
@@ -108,13 +120,34 @@ function createZip(entries) {
   eocd.writeUInt32LE(0x06054B50, 0);       // signature
   eocd.writeUInt16LE(0, 4);                // disk number
   eocd.writeUInt16LE(0, 6);                // disk with central dir
-  eocd.writeUInt16LE(entries.length, 8);   // entries on this disk
-  eocd.writeUInt16LE(entries.length, 10);  // total entries
-  eocd.writeUInt32LE(centralDirSize, 12);
-  eocd.writeUInt32LE(centralDirOffset, 16);
+  eocd.writeUInt16LE(zip64 ? 0xFFFF : entries.length, 8);   // entries on this disk
+  eocd.writeUInt16LE(zip64 ? 0xFFFF : entries.length, 10);  // total entries
+  eocd.writeUInt32LE(zip64 ? 0xFFFFFFFF : centralDirSize, 12);
+  eocd.writeUInt32LE(zip64 ? 0xFFFFFFFF : centralDirOffset, 16);
   eocd.writeUInt16LE(0, 20);               // comment length
 
-  return Buffer.concat([...localHeaders, ...centralEntries, eocd]);
+  if (!zip64) return Buffer.concat([...localHeaders, ...centralEntries, eocd]);
+
+  // ZIP64 end of central directory record (56 bytes) and locator (20 bytes)
+  const eocd64Offset = centralDirOffset + centralDirSize;
+  const eocd64 = Buffer.alloc(56);
+  eocd64.writeUInt32LE(0x06064B50, 0);     // signature
+  eocd64.writeBigUInt64LE(44n, 4);         // size of remaining record
+  eocd64.writeUInt16LE(45, 12);            // version made by
+  eocd64.writeUInt16LE(45, 14);            // version needed
+  eocd64.writeUInt32LE(0, 16);             // disk number
+  eocd64.writeUInt32LE(0, 20);             // disk with central dir
+  eocd64.writeBigUInt64LE(BigInt(entries.length), 24);
+  eocd64.writeBigUInt64LE(BigInt(entries.length), 32);
+  eocd64.writeBigUInt64LE(BigInt(centralDirSize), 40);
+  eocd64.writeBigUInt64LE(BigInt(centralDirOffset), 48);
+  const locator = Buffer.alloc(20);
+  locator.writeUInt32LE(0x07064B50, 0);    // signature
+  locator.writeUInt32LE(0, 4);             // disk with ZIP64 end record
+  locator.writeBigUInt64LE(BigInt(eocd64Offset), 8);
+  locator.writeUInt32LE(1, 16);            // total disks
+
+  return Buffer.concat([...localHeaders, ...centralEntries, eocd64, locator, eocd]);
 }
 
 /**
@@ -208,6 +241,8 @@ function loremParagraph(seed) {
  * @param {string} opts.author - Book author
  * @param {number} opts.chapters - Number of chapters (default 3)
  * @param {number} opts.paragraphsPerChapter - Paragraphs per chapter (default 12)
+ * @param {string[]} opts.tocLabels - Nav TOC labels per chapter (default "Chapter N")
+ * @param {string[]} opts.tocHrefs - Nav TOC hrefs per chapter (default "chapterN.xhtml")
  * @returns {Buffer} EPUB file contents
  */
 // Minimal 1x1 red PNG (68 bytes) for testing image rendering
@@ -224,6 +259,12 @@ export function createEpub(opts = {}) {
   const coverImage = opts.coverImage || false;
   const svgCover = opts.svgCover || false;
   const rawChapters = opts.rawChapters || null; // array of {body, images?}
+  const fillerEntries = opts.fillerEntries || 0; // unreferenced entries ahead of the content
+  const manifestFillers = opts.manifestFillers || false; // list the fillers as manifest items
+  // Cover image manifest href and ZIP entry name, for path normalization tests
+  const coverHref = opts.coverHref || 'images/cover.png';
+  const coverEntry = opts.coverEntryName || 'OEBPS/images/cover.png';
+  const fillerDir = 'filler' + (opts.fillerNamePad ? '/' + 'x'.repeat(opts.fillerNamePad) : '');
 
   // mimetype must be first entry, stored uncompressed
   const mimetype = 'application/epub+zip';
@@ -241,6 +282,13 @@ export function createEpub(opts = {}) {
   let spineItems = '';
   const chapters = [];
 
+  // Filler items ahead of the chapters, so spine ids resolve late in the manifest
+  if (manifestFillers) {
+    for (let i = 0; i < fillerEntries; i++) {
+      manifestItems += `    <item id="f${i}" href="${fillerDir}/f${i}.txt" media-type="text/plain"/>\n`;
+    }
+  }
+
   // SVG cover wrap page (like real-world EPUBs that use <svg><image> for covers)
   if (svgCover) {
     manifestItems += `    <item id="coverpage-wrapper" href="wrap0000.xhtml" media-type="application/xhtml+xml" properties="svg"/>\n`;
@@ -289,13 +337,15 @@ ${rawBody}
 
   // Add cover image if requested (EPUB3: properties="cover-image")
   if (coverImage) {
-    manifestItems += `    <item id="cover-img" href="images/cover.png" media-type="image/png" properties="cover-image"/>\n`;
+    manifestItems += `    <item id="cover-img" href="${coverHref}" media-type="image/png" properties="cover-image"/>\n`;
   }
 
   // Build TOC nav document
   let tocItems = '';
   for (let i = 1; i <= numChapters; i++) {
-    tocItems += `        <li><a href="chapter${i}.xhtml">Chapter ${i}</a></li>\n`;
+    const label = (opts.tocLabels && opts.tocLabels[i - 1]) || `Chapter ${i}`;
+    const href = (opts.tocHrefs && opts.tocHrefs[i - 1]) || `chapter${i}.xhtml`;
+    tocItems += `        <li><a href="${href}">${label}</a></li>\n`;
   }
 
   const navXhtml = `<?xml version="1.0" encoding="UTF-8"?>
@@ -359,11 +409,15 @@ ${spineItems}  </spine>
   if (opts.storeChapters) {
     chapters.forEach(ch => { ch.store = true; });
   }
+  // Filler entries push the content past fixed-size entry tables
+  for (let i = 0; i < fillerEntries; i++) {
+    zipEntries.push({ name: `OEBPS/${fillerDir}/f${i}.txt`, data: `${i}`, store: true });
+  }
   zipEntries.push(...chapters);
 
   // Add cover image as stored (uncompressed) entry for synchronous reading
   if (coverImage) {
-    zipEntries.push({ name: 'OEBPS/images/cover.png', data: TINY_PNG, store: true });
+    zipEntries.push({ name: coverEntry, data: TINY_PNG, store: true });
   }
 
   // Add extra images (for rawChapters that reference images)
@@ -373,5 +427,5 @@ ${spineItems}  </spine>
     }
   }
 
-  return createZip(zipEntries);
+  return createZip(zipEntries, { zip64: opts.zip64 || false });
 }
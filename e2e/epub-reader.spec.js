@@ -9,7 +9,7 @@
  */
 
 import { test, expect } from '@playwright/test';
-import { createEpub } from './create-epub.js';
+import { createEpub, TINY_PNG } from './create-epub.js';
 import { writeFileSync, mkdirSync } from 'node:fs';
 import { join } from 'node:path';
 
@@ -778,6 +778,157 @@ test.describe('EPUB Reader E2E', () => {
     await page.waitForSelector('.book-card', { timeout: 10000 });
   });
 
+  test('imports an epub with 5000 entries and ZIP64 records', async ({ page }) => {
+    // Filler entries put the chapters and the cover image (the last entry)
+    // past the old 256-entry table, and every size and offset is only
+    // in the ZIP64 records. The book is reopened after a reload so the
+    // manifest's persisted path index is exercised too.
+    const epubBuffer = createEpub({
+      title: 'Many Entries Book',
+      author: 'Zip64 Author',
+      chapters: 2,
+      paragraphsPerChapter: 3,
+      coverImage: true,
+      fillerEntries: 5000,
+      zip64: true,
+    });
+
+    await page.goto('/');
+    await page.waitForSelector('.library-list', { timeout: 15000 });
+
+    const fileInput = page.locator('input[type="file"]');
+    const epubPath = join(SCREENSHOT_DIR, 'many-entries-zip64.epub');
+    writeFileSync(epubPath, epubBuffer);
+    await fileInput.setInputFiles(epubPath);
+    await page.waitForSelector('.book-card', { timeout: 60000 });
+    await expect(page.locator('.book-title')).toContainText('Many Entries Book');
+
+    // Wait for IDB save to complete, then reopen from the stored manifest
+    await page.waitForTimeout(2000);
+    await page.reload();
+    await page.waitForSelector('.book-card', { timeout: 15000 });
+
+    await page.locator('.book-card').click();
+    await page.waitForSelector('.reader-viewport', { timeout: 15000 });
+
+    // Chapter 1 resolves and renders the cover image stored last
+    await page.waitForFunction(() => {
+      const img = document.querySelector('.chapter-container img');
+      return img && img.src && img.src.length > 0;
+    }, { timeout: 15000 });
+    const textLen = await page.locator('.chapter-container').first()
+      .evaluate(el => el.textContent.length);
+    expect(textLen).toBeGreaterThan(100);
+    await screenshot(page, 'many-entries-chapter1');
+  });
+
+  test('resolves spine items listed after 4000 manifest items', async ({ page }) => {
+    // The manifest id hash is sized from the archive, so chapters listed
+    // after thousands of other items still resolve instead of dropping
+    // out of the spine.
+    const epubBuffer = createEpub({
+      title: 'Long Manifest Book',
+      author: 'Manifest Author',
+      chapters: 3,
+      paragraphsPerChapter: 3,
+      fillerEntries: 4000,
+      manifestFillers: true,
+    });
+
+    await page.goto('/');
+    await page.waitForSelector('.library-list', { timeout: 15000 });
+
+    const epubPath = join(SCREENSHOT_DIR, 'long-manifest.epub');
+    writeFileSync(epubPath, epubBuffer);
+    await page.locator('input[type="file"]').setInputFiles(epubPath);
+    await page.waitForSelector('.book-card', { timeout: 60000 });
+    await expect(page.locator('.book-title')).toContainText('Long Manifest Book');
+
+    await page.locator('.book-card').click();
+    await page.waitForSelector('.reader-viewport', { timeout: 15000 });
+    await page.waitForTimeout(1000);
+    await expect(page.locator('.chapter-container').first()).toContainText('Chapter 1');
+
+    // The last spine item resolves too
+    await page.locator('.toc-btn').click();
+    await page.waitForTimeout(300);
+    const tocEntries = page.locator('.toc-entry');
+    await expect(tocEntries).toHaveCount(3);
+    await tocEntries.nth(2).click();
+    await expect(page.locator('.chapter-container').first()).toContainText('Chapter 3',
+      { timeout: 15000 });
+    await screenshot(page, 'long-manifest-chapter3');
+  });
+
+  test('rejects an archive whose manifest would not fit before storing it', async ({ page }) => {
+    // 6000 entries with ~170-byte names fit the ZIP tables but make a
+    // manifest over 1 MB; the import fails with the manifest error
+    // right after the OPF is parsed and no book is added.
+    const errors = [];
+    page.on('pageerror', err => errors.push(err.message));
+    const epubBuffer = createEpub({
+      title: 'Oversized Manifest',
+      chapters: 1,
+      paragraphsPerChapter: 2,
+      fillerEntries: 6000,
+      fillerNamePad: 147,
+    });
+
+    await page.goto('/');
+    await page.waitForSelector('.library-list', { timeout: 15000 });
+
+    const epubPath = join(SCREENSHOT_DIR, 'oversized-manifest.epub');
+    writeFileSync(epubPath, epubBuffer);
+    await page.locator('input[type="file"]').setInputFiles(epubPath);
+
+    const banner = page.locator('.err-banner');
+    await expect(banner).toBeVisible({ timeout: 60000 });
+    await expect(banner).toContainText('Import failed');
+    await expect(page.locator('.book-title')).toHaveCount(0);
+    await screenshot(page, 'oversized-manifest-banner');
+    expect(errors).toEqual([]);
+  });
+
+  test('normalizes dot segments in entry names and hrefs', async ({ page }) => {
+    // The cover entry is stored under a name with "." and "seg/.."
+    // segments and the OPF names it through another such path; both
+    // normalize to OEBPS/images/cover.png, which chapter 1 also uses.
+    // An entry climbing above the archive root is ignored.
+    const errors = [];
+    page.on('pageerror', err => errors.push(err.message));
+    const epubBuffer = createEpub({
+      title: 'Dot Segments',
+      chapters: 2,
+      paragraphsPerChapter: 3,
+      coverImage: true,
+      coverEntryName: 'OEBPS/./junk/../images/cover.png',
+      coverHref: 'images/./old/../cover.png',
+      extraImages: [{ name: '../../escape.png', data: TINY_PNG }],
+    });
+
+    await page.goto('/');
+    await page.waitForSelector('.library-list', { timeout: 15000 });
+
+    const epubPath = join(SCREENSHOT_DIR, 'dot-segments.epub');
+    writeFileSync(epubPath, epubBuffer);
+    await page.locator('input[type="file"]').setInputFiles(epubPath);
+    await page.waitForSelector('.book-card', { timeout: 30000 });
+
+    await page.waitForFunction(() => {
+      const img = document.querySelector('.book-card img.book-cover');
+      return img && img.src && img.src.length > 0;
+    }, { timeout: 15000 });
+
+    await page.locator('.book-card').click();
+    await page.waitForSelector('.reader-viewport', { timeout: 15000 });
+    await page.waitForFunction(() => {
+      const img = document.querySelector('.chapter-container img');
+      return img && img.src && img.src.length > 0;
+    }, { timeout: 15000 });
+    await screenshot(page, 'dot-segments-chapter1');
+    expect(errors).toEqual([]);
+  });
+
   test('library persists across page reload', async ({ page }) => {
     // Import a book, reload the page, and verify the book is still there.
     const epubBuffer = createEpub({
@@ -1624,6 +1775,85 @@ test.describe('EPUB Reader E2E', () => {
     expect(errors).toEqual([]);
   });
 
+  test('page turns read no layout', async ({ page }) => {
+    // The reader caches page width after a chapter renders; a page turn
+    // should then be a pure transform write, whether the page is new or
+    // already visited. Turn forward past the periodic position save, go
+    // back and forth, and check the layout read counter stays put.
+    const epubBuffer = createEpub({
+      title: 'Layout Cache Test',
+      author: 'Layout Bot',
+      chapters: 1,
+      paragraphsPerChapter: 60,
+    });
+
+    const errors = [];
+    page.on('pageerror', err => errors.push(err.message));
+
+    await page.goto('/');
+    await page.waitForSelector('.library-list', { timeout: 15000 });
+
+    const fileInput = page.locator('input[type="file"]');
+    const vp = page.viewportSize();
+    const epubPath = join(SCREENSHOT_DIR, `layout-cache-${vp.width}x${vp.height}.epub`);
+    writeFileSync(epubPath, epubBuffer);
+    await fileInput.setInputFiles(epubPath);
+    await page.waitForSelector('.book-card', { timeout: 30000 });
+
+    await page.locator('.book-card').click();
+    await page.waitForSelector('.reader-viewport', { timeout: 15000 });
+    await page.waitForFunction(() => {
+      const el = document.querySelector('.chapter-container');
+      return el && el.childElementCount > 0;
+    }, { timeout: 15000 });
+    await page.waitForTimeout(1000);
+
+    const pageInfo = page.locator('.page-info');
+    const initialText = await pageInfo.textContent();
+    const totalPages = parseInt(initialText.match(/\s+\d+\/(\d+)$/)[1]);
+    const flips = Math.min(6, totalPages - 1);
+    expect(flips).toBeGreaterThan(0);
+    await page.locator('.reader-viewport').focus();
+    const readsAfterRender = await page.evaluate(() => window.quireLayoutReads());
+
+    // First visits: forward onto pages never shown before
+    for (let i = 0; i < flips; i++) {
+      await page.keyboard.press('ArrowRight');
+      await page.waitForTimeout(100);
+    }
+    expect(await pageInfo.textContent()).toMatch(new RegExp(`\\s+${flips + 1}\\/\\d+$`));
+    const readsAfterVisit = await page.evaluate(() => window.quireLayoutReads());
+    expect(readsAfterVisit).toBe(readsAfterRender);
+
+    // Revisits: back to the start and forward again
+    for (let i = 0; i < flips; i++) {
+      await page.keyboard.press('ArrowLeft');
+      await page.waitForTimeout(100);
+    }
+    expect(await pageInfo.textContent()).toMatch(/\s+1\/\d+$/);
+    for (let i = 0; i < flips; i++) {
+      await page.keyboard.press('ArrowRight');
+      await page.waitForTimeout(100);
+    }
+    expect(await pageInfo.textContent()).toMatch(new RegExp(`\\s+${flips + 1}\\/\\d+$`));
+    expect(await page.evaluate(() => window.quireLayoutReads())).toBe(readsAfterVisit);
+
+    // A resize re-measures at once and realigns the shown page
+    await page.setViewportSize({ width: vp.width - 40, height: vp.height });
+    await page.waitForTimeout(300);
+    expect(await page.evaluate(() => window.quireLayoutReads())).toBeGreaterThan(readsAfterVisit);
+    const shown = parseInt((await pageInfo.textContent()).match(/\s+(\d+)\/\d+$/)[1]);
+    const align = await page.evaluate(() => {
+      const vpEl = document.querySelector('.reader-viewport');
+      const m = document.querySelector('.chapter-container').style.transform
+        .match(/translateX\(-?(\d+)px\)/);
+      return { x: m ? parseInt(m[1]) : 0, w: Math.round(vpEl.getBoundingClientRect().width) };
+    });
+    expect(align.x).toBe((shown - 1) * align.w);
+
+    expect(errors).toEqual([]);
+  });
+
   test('reading position persists across page turns within a chapter', async ({ page }) => {
     // Import a book with enough text for multiple pages in one chapter,
     // flip forward several pages, go back to library, re-enter the book,
@@ -2029,6 +2259,94 @@ test('bookmark toggle via button click and B key', async ({ page }) => {
     expect(errors).toEqual([]);
   });
 
+  test('toc entries use labels from the nav document', async ({ page }) => {
+    const errors = [];
+    page.on('pageerror', err => errors.push(err.message));
+
+    const labels = [
+      'Prologue &amp; Preface',
+      'The <em>Long</em> Road',
+      'Caf&#xE9; &#8212; <![CDATA[<Epilogue>]]>',
+    ];
+    const epubBuffer = createEpub({
+      title: 'TOC Labels',
+      author: 'Quire Bot',
+      chapters: 3,
+      tocLabels: labels,
+    });
+
+    await page.goto('/');
+    await page.waitForSelector('.library-list', { timeout: 15000 });
+
+    const vp = page.viewportSize();
+    const epubPath = join(SCREENSHOT_DIR, `toc-labels-${vp.width}x${vp.height}.epub`);
+    writeFileSync(epubPath, epubBuffer);
+    await page.locator('input[type="file"]').setInputFiles(epubPath);
+
+    await page.waitForSelector('.book-card', { timeout: 30000 });
+    await page.locator('.book-card').click();
+    await page.waitForSelector('.reader-viewport', { timeout: 15000 });
+    await page.waitForTimeout(1000);
+
+    await page.locator('.toc-btn').click();
+    await page.waitForTimeout(300);
+
+    // Inline markup in a nav label is dropped, its text kept; entities,
+    // character references and CDATA are decoded
+    const tocEntries = page.locator('.toc-entry');
+    await expect(tocEntries).toHaveCount(3);
+    await expect(tocEntries.nth(0)).toHaveText('Prologue & Preface');
+    await expect(tocEntries.nth(1)).toHaveText('The Long Road');
+    await expect(tocEntries.nth(2)).toHaveText('Caf\u00e9 \u2014 <Epilogue>');
+    await screenshot(page, 'toc-labels-01-nav-labels');
+
+    expect(errors).toEqual([]);
+  });
+
+  test('toc hrefs are percent-decoded before matching the spine', async ({ page }) => {
+    const errors = [];
+    page.on('pageerror', err => errors.push(err.message));
+
+    // "%32" is "2" and "%2E" is "."; the fragment is ignored
+    const epubBuffer = createEpub({
+      title: 'TOC Hrefs',
+      author: 'Quire Bot',
+      chapters: 3,
+      paragraphsPerChapter: 3,
+      tocHrefs: ['chapter1.xhtml', 'chapter%32%2Exhtml#start', './chapter%33.xhtml'],
+    });
+
+    await page.goto('/');
+    await page.waitForSelector('.library-list', { timeout: 15000 });
+
+    const vp = page.viewportSize();
+    const epubPath = join(SCREENSHOT_DIR, `toc-hrefs-${vp.width}x${vp.height}.epub`);
+    writeFileSync(epubPath, epubBuffer);
+    await page.locator('input[type="file"]').setInputFiles(epubPath);
+
+    await page.waitForSelector('.book-card', { timeout: 30000 });
+    await page.locator('.book-card').click();
+    await page.waitForSelector('.reader-viewport', { timeout: 15000 });
+    await page.waitForTimeout(1000);
+
+    await page.locator('.toc-btn').click();
+    await page.waitForTimeout(300);
+    const tocEntries = page.locator('.toc-entry');
+    await expect(tocEntries).toHaveCount(3);
+    await tocEntries.nth(1).click();
+    await expect(page.locator('.chapter-container').first()).toContainText('Chapter 2',
+      { timeout: 15000 });
+
+    await page.locator('.toc-btn').click();
+    await page.waitForTimeout(300);
+    await tocEntries.nth(2).click();
+    await expect(page.locator('.chapter-container').first()).toContainText('Chapter 3',
+      { timeout: 15000 });
+    await screenshot(page, 'toc-hrefs-01-chapter3');
+
+    expect(errors).toEqual([]);
+  });
+
   test('position stack: TOC navigation shows nav-back button, pop restores position', async ({ page }) => {
     // This test verifies the position stack feature:
     // 1. Nav-back button is hidden on reader load
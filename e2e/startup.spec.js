@@ -0,0 +1,82 @@
+/**
+ * Startup benchmark: time to interactive with a 100-book library.
+ *
+ * Imports 100 small EPUBs, then reloads and reads the timings index.html
+ * records in window.quireStartup (ms since navigation start):
+ *   snapshot     saved library view painted (before the module loads)
+ *   compiled     quire.wasm compiled (or taken from the module cache)
+ *   interactive  the engine's own library view is on screen
+ *
+ * Slow to set up, so it runs on the desktop project only and is not part
+ * of the CI suite: npx playwright test e2e/startup.spec.js --project=desktop
+ */
+
+import { test, expect } from '@playwright/test';
+import { createEpub } from './create-epub.js';
+import { writeFileSync, mkdirSync } from 'node:fs';
+import { join } from 'node:path';
+
+const SCREENSHOT_DIR = join(process.cwd(), 'e2e', 'screenshots');
+mkdirSync(SCREENSHOT_DIR, { recursive: true });
+
+const BOOKS = 100;
+const RUNS = 3;
+
+test.describe('Startup', () => {
+  test('time to interactive with a 100-book library', async ({ page }, testInfo) => {
+    test.skip(testInfo.project.name !== 'desktop', 'benchmark runs on desktop only');
+    test.setTimeout(15 * 60 * 1000);
+
+    const errors = [];
+    page.on('pageerror', err => errors.push(err.message));
+
+    await page.goto('/');
+    await page.waitForSelector('.library-list', { timeout: 15000 });
+
+    const fileInput = page.locator('input[type="file"]');
+    for (let i = 0; i < BOOKS; i++) {
+      const epubPath = join(SCREENSHOT_DIR, `startup-${i}.epub`);
+      writeFileSync(epubPath, createEpub({
+        title: `Startup Book ${String(i).padStart(3, '0')}`,
+        author: `Author ${i % 17}`,
+        chapters: 2,
+        paragraphsPerChapter: 2,
+      }));
+      await fileInput.setInputFiles(epubPath);
+      await expect(page.locator('.book-card')).toHaveCount(i + 1, { timeout: 30000 });
+    }
+    // Let the final library save land in IDB
+    await page.waitForTimeout(2000);
+
+    const samples = [];
+    for (let run = 0; run < RUNS; run++) {
+      await page.reload();
+      await page.waitForFunction(() =>
+        window.quireStartup && window.quireStartup.interactive !== null,
+        null, { timeout: 30000 });
+      await expect(page.locator('.book-card')).toHaveCount(BOOKS);
+      samples.push(await page.evaluate(() => ({ ...window.quireStartup })));
+    }
+
+    // Every reload after the first import has a snapshot to paint, and
+    // paints it before the engine is up.
+    for (const s of samples) {
+      expect(s.snapshot).not.toBeNull();
+      expect(s.snapshot).toBeLessThan(s.interactive);
+    }
+
+    const median = key => {
+      const v = samples.map(s => s[key]).sort((a, b) => a - b);
+      return v[Math.floor(v.length / 2)];
+    };
+    const report =
+      `${BOOKS} books, median of ${RUNS}: ` +
+      `snapshot ${median('snapshot').toFixed(1)} ms, ` +
+      `compiled ${median('compiled').toFixed(1)} ms, ` +
+      `interactive ${median('interactive').toFixed(1)} ms`;
+    console.log(report);
+    testInfo.annotations.push({ type: 'startup', description: report });
+
+    expect(errors).toEqual([]);
+  });
+});
@@ -0,0 +1,465 @@
+/* host_bridge.c -- Native stand-in for ward_bridge.mjs and runtime.c
+ *
+ * Provides every C symbol the ATS-generated code expects from the WASM
+ * environment: the runtime.c tables (stash, measure, listener, resolver,
+ * arena), the libc forwarders named by host_runtime.h, and the JS
+ * imports declared in runtime.h / quire_ext.sats.
+ *
+ * Only the imports the parsing core reaches are implemented for real
+ * (file read, IDB, decompress, HTML parse, timers, log). DOM, fetch,
+ * clipboard and notification imports abort: reaching one means the
+ * host link set pulled in UI code it should not have.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+#include "host_bridge.h"
+
+/* WASM exports implemented in ATS (ward idb/decompress/event/promise) */
+void ward_idb_fire(int resolver_id, int status);
+void ward_idb_fire_get(int resolver_id, int data_len);
+void ward_on_decompress_complete(int resolver_id, int handle, int len);
+void ward_timer_fire(int resolver_id);
+void _ward_resolve_chain(void *p, void *v);
+
+static void host_unreachable(const char *name) __attribute__((noreturn));
+static void host_unreachable(const char *name) {
+  fprintf(stderr, "quire-host: %s is not available in the host build\n", name);
+  abort();
+}
+
+static void *host_xmalloc(size_t n) {
+  void *p = malloc(n ? n : 1);
+  if (!p) { fprintf(stderr, "quire-host: out of memory\n"); abort(); }
+  return p;
+}
+
+/* ========== libc forwarders (see host_runtime.h) ========== */
+
+/* ward's allocator returns zeroed blocks; ATS code relies on it. */
+void *quire_host_malloc(int size) {
+  return calloc(1, size > 0 ? (size_t)size : 1);
+}
+void quire_host_free(void *p) { free(p); }
+void *quire_host_memset(void *s, int c, unsigned int n) { return memset(s, c, n); }
+void *quire_host_memcpy(void *d, const void *s, unsigned int n) { return memcpy(d, s, n); }
+
+/* ========== runtime.c tables ========== */
+
+static int host_stash_int[4];
+void ward_bridge_stash_set_int(int slot, int v) { host_stash_int[slot] = v; }
+int ward_bridge_stash_get_int(int slot) { return host_stash_int[slot]; }
+
+static int host_measure[6];
+void ward_measure_set(int slot, int v) { host_measure[slot] = v; }
+int ward_measure_get(int slot) { return host_measure[slot]; }
+
+#define HOST_MAX_LISTENERS 128
+static void *host_listeners[HOST_MAX_LISTENERS];
+void ward_listener_set(int id, void *cb) {
+  if (id >= 0 && id < HOST_MAX_LISTENERS) host_listeners[id] = cb;
+}
+void *ward_listener_get(int id) {
+  if (id >= 0 && id < HOST_MAX_LISTENERS) return host_listeners[id];
+  return NULL;
+}
+
+#define HOST_MAX_RESOLVERS 64
+static void *host_resolvers[HOST_MAX_RESOLVERS];
+int ward_resolver_stash(void *resolver) {
+  for (int i = 0; i < HOST_MAX_RESOLVERS; i++) {
+    if (!host_resolvers[i]) { host_resolvers[i] = resolver; return i; }
+  }
+  return -1;
+}
+void *ward_resolver_unstash(int id) {
+  if (id < 0 || id >= HOST_MAX_RESOLVERS) return NULL;
+  void *r = host_resolvers[id];
+  host_resolvers[id] = NULL;
+  return r;
+}
+void ward_resolver_fire(int id, int value) {
+  void *r = ward_resolver_unstash(id);
+  if (r) _ward_resolve_chain(r, (void *)(long)value);
+}
+
+void *ward_arena_create(int max_size) {
+  int *p = calloc(1, (size_t)max_size + 8);
+  if (!p) return NULL;
+  p[0] = max_size;
+  p[1] = 0;
+  return p;
+}
+void *ward_arena_alloc(void *arena, int size) {
+  int *a = arena;
+  int used = (a[1] + 7) & ~7;
+  if (used + size > a[0]) return NULL;
+  a[1] = used + size;
+  return (char *)arena + 8 + used;
+}
+void ward_arena_destroy(void *arena) { free(arena); }
+
+/* ========== Completion queue ========== */
+
+enum { Q_IDB_FIRE, Q_IDB_GET, Q_DECOMPRESS, Q_TIMER };
+
+typedef struct { int kind, rid, a, b; } host_event;
+
+static host_event *host_q;
+static int host_q_head, host_q_tail, host_q_cap;
+
+static void host_enqueue(int kind, int rid, int a, int b) {
+  if (host_q_tail == host_q_cap) {
+    if (host_q_head > 0) {
+      memmove(host_q, host_q + host_q_head,
+              (size_t)(host_q_tail - host_q_head) * sizeof *host_q);
+      host_q_tail -= host_q_head;
+      host_q_head = 0;
+    }
+    if (host_q_tail == host_q_cap) {
+      host_q_cap = host_q_cap ? host_q_cap * 2 : 64;
+      host_q = realloc(host_q, (size_t)host_q_cap * sizeof *host_q);
+      if (!host_q) host_unreachable("realloc");
+    }
+  }
+  host_q[host_q_tail++] = (host_event){ kind, rid, a, b };
+}
+
+int quire_host_drain(void) {
+  int n = 0;
+  while (host_q_head < host_q_tail) {
+    host_event e = host_q[host_q_head++];
+    n++;
+    switch (e.kind) {
+    case Q_IDB_FIRE:   ward_idb_fire(e.rid, e.a); break;
+    case Q_IDB_GET:
+      /* stash id must be in slot 1 at delivery time, as in the bridge */
+      if (e.b > 0) ward_bridge_stash_set_int(1, e.a);
+      ward_idb_fire_get(e.rid, e.b);
+      break;
+    case Q_DECOMPRESS: ward_on_decompress_complete(e.rid, e.a, e.b); break;
+    case Q_TIMER:      ward_timer_fire(e.rid); break;
+    }
+  }
+  host_q_head = host_q_tail = 0;
+  return n;
+}
+
+/* ========== Data stash (ward_js_stash_read) ========== */
+
+typedef struct { unsigned char *data; int len; } host_bytes;
+
+static host_bytes *host_stash;
+static int host_stash_cap;
+
+static int host_stash_put(unsigned char *data, int len) {
+  for (int i = 0; i < host_stash_cap; i++) {
+    if (!host_stash[i].data) {
+      host_stash[i] = (host_bytes){ data, len };
+      return i;
+    }
+  }
+  int id = host_stash_cap;
+  host_stash_cap = host_stash_cap ? host_stash_cap * 2 : 16;
+  host_stash = realloc(host_stash, (size_t)host_stash_cap * sizeof *host_stash);
+  if (!host_stash) host_unreachable("realloc");
+  memset(host_stash + id, 0, (size_t)(host_stash_cap - id) * sizeof *host_stash);
+  host_stash[id] = (host_bytes){ data, len };
+  return id;
+}
+
+void ward_js_stash_read(int stash_id, void *dest, int len) {
+  if (stash_id < 0 || stash_id >= host_stash_cap) return;
+  host_bytes *s = &host_stash[stash_id];
+  if (!s->data) return;
+  memcpy(dest, s->data, (size_t)(len < s->len ? len : s->len));
+  free(s->data);
+  s->data = NULL;
+}
+
+/* ========== Files ========== */
+
+#define HOST_MAX_FILES 16
+static host_bytes host_files[HOST_MAX_FILES];
+
+int quire_host_file_add(const char *path, int *size_out) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return 0;
+  if (fseek(f, 0, SEEK_END) != 0) { fclose(f); return 0; }
+  long sz = ftell(f);
+  rewind(f);
+  if (sz < 0 || sz > 0x7fffffffL) { fclose(f); return 0; }
+  unsigned char *data = host_xmalloc((size_t)sz);
+  size_t got = fread(data, 1, (size_t)sz, f);
+  fclose(f);
+  if (got != (size_t)sz) { free(data); return 0; }
+  for (int h = 1; h < HOST_MAX_FILES; h++) {
+    if (!host_files[h].data) {
+      host_files[h] = (host_bytes){ data, (int)sz };
+      *size_out = (int)sz;
+      return h;
+    }
+  }
+  free(data);
+  return 0;
+}
+
+void ward_js_file_open(int input_node_id, int resolver_id) {
+  (void)input_node_id; (void)resolver_id;
+  host_unreachable("ward_js_file_open (use quire_host_file_add)");
+}
+
+int ward_js_file_read(int handle, int file_offset, int len, void *out) {
+  if (handle <= 0 || handle >= HOST_MAX_FILES) return 0;
+  host_bytes *f = &host_files[handle];
+  if (!f->data || file_offset < 0 || file_offset >= f->len || len <= 0) return 0;
+  int n = f->len - file_offset < len ? f->len - file_offset : len;
+  memcpy(out, f->data + file_offset, (size_t)n);
+  return n;
+}
+
+void ward_js_file_close(int handle) {
+  if (handle <= 0 || handle >= HOST_MAX_FILES) return;
+  free(host_files[handle].data);
+  host_files[handle].data = NULL;
+}
+
+/* ========== IndexedDB (in-memory) ========== */
+
+typedef struct host_rec {
+  struct host_rec *next;
+  unsigned char *key; int key_len;
+  unsigned char *val; int val_len;
+} host_rec;
+
+#define HOST_IDB_BUCKETS 4096
+static host_rec *host_idb[HOST_IDB_BUCKETS];
+
+static unsigned host_key_hash(const unsigned char *k, int n) {
+  unsigned h = 2166136261u;                 /* FNV-1a */
+  for (int i = 0; i < n; i++) { h ^= k[i]; h *= 16777619u; }
+  return h & (HOST_IDB_BUCKETS - 1);
+}
+
+static host_rec **host_idb_slot(const unsigned char *k, int n) {
+  host_rec **pp = &host_idb[host_key_hash(k, n)];
+  while (*pp && !((*pp)->key_len == n && memcmp((*pp)->key, k, (size_t)n) == 0))
+    pp = &(*pp)->next;
+  return pp;
+}
+
+void ward_idb_js_put(void *key, int key_len, void *val, int val_len, int rid) {
+  host_rec **pp = host_idb_slot(key, key_len);
+  host_rec *r = *pp;
+  if (!r) {
+    r = host_xmalloc(sizeof *r);
+    r->next = NULL;
+    r->key = host_xmalloc((size_t)key_len);
+    memcpy(r->key, key, (size_t)key_len);
+    r->key_len = key_len;
+    *pp = r;
+  } else {
+    free(r->val);
+  }
+  r->val = host_xmalloc((size_t)val_len);
+  memcpy(r->val, val, (size_t)val_len);
+  r->val_len = val_len;
+  host_enqueue(Q_IDB_FIRE, rid, 0, 0);
+}
+
+void ward_idb_js_get(void *key, int key_len, int rid) {
+  host_rec *r = *host_idb_slot(key, key_len);
+  if (!r || r->val_len == 0) {
+    host_enqueue(Q_IDB_GET, rid, 0, 0);
+    return;
+  }
+  unsigned char *copy = host_xmalloc((size_t)r->val_len);
+  memcpy(copy, r->val, (size_t)r->val_len);
+  host_enqueue(Q_IDB_GET, rid, host_stash_put(copy, r->val_len), r->val_len);
+}
+
+int quire_host_idb_get_sync(void *key, int key_len) {
+  host_rec *r = *host_idb_slot(key, key_len);
+  if (!r || r->val_len == 0) return 0;
+  unsigned char *copy = host_xmalloc((size_t)r->val_len);
+  memcpy(copy, r->val, (size_t)r->val_len);
+  ward_bridge_stash_set_int(1, host_stash_put(copy, r->val_len));
+  return r->val_len;
+}
+
+void ward_idb_js_delete(void *key, int key_len, int rid) {
+  host_rec **pp = host_idb_slot(key, key_len);
+  host_rec *r = *pp;
+  if (r) {
+    *pp = r->next;
+    free(r->key); free(r->val); free(r);
+  }
+  host_enqueue(Q_IDB_FIRE, rid, 0, 0);
+}
+
+void quire_host_idb_clear(void) {
+  for (int i = 0; i < HOST_IDB_BUCKETS; i++) {
+    host_rec *r = host_idb[i];
+    while (r) {
+      host_rec *next = r->next;
+      free(r->key); free(r->val); free(r);
+      r = next;
+    }
+    host_idb[i] = NULL;
+  }
+}
+
+int quire_host_idb_count(void) {
+  int n = 0;
+  for (int i = 0; i < HOST_IDB_BUCKETS; i++)
+    for (host_rec *r = host_idb[i]; r; r = r->next) n++;
+  return n;
+}
+
+long quire_host_idb_bytes(void) {
+  long n = 0;
+  for (int i = 0; i < HOST_IDB_BUCKETS; i++)
+    for (host_rec *r = host_idb[i]; r; r = r->next) n += r->val_len;
+  return n;
+}
+
+/* ========== Decompress (zlib) ========== */
+
+#define HOST_MAX_BLOBS 64
+static host_bytes host_blobs[HOST_MAX_BLOBS];
+
+/* method: 0=gzip, 1=deflate (zlib wrapper), 2=deflate-raw */
+static int host_inflate(const unsigned char *src, int len, int method,
+                        unsigned char **out) {
+  static const int wbits[3] = { 16 + MAX_WBITS, MAX_WBITS, -MAX_WBITS };
+  if (method < 0 || method > 2) return -1;
+  z_stream zs;
+  memset(&zs, 0, sizeof zs);
+  if (inflateInit2(&zs, wbits[method]) != Z_OK) return -1;
+  size_t cap = (size_t)len * 4 + 1024, used = 0;
+  unsigned char *buf = host_xmalloc(cap);
+  zs.next_in = (unsigned char *)src;
+  zs.avail_in = (unsigned)len;
+  int rc;
+  do {
+    if (used == cap) {
+      cap *= 2;
+      buf = realloc(buf, cap);
+      if (!buf) host_unreachable("realloc");
+    }
+    zs.next_out = buf + used;
+    zs.avail_out = (unsigned)(cap - used);
+    rc = inflate(&zs, Z_NO_FLUSH);
+    used = cap - zs.avail_out;
+  } while (rc == Z_OK);
+  inflateEnd(&zs);
+  if (rc != Z_STREAM_END || used > 0x7fffffff) { free(buf); return -1; }
+  *out = buf;
+  return (int)used;
+}
+
+void ward_js_decompress(void *data, int data_len, int method, int rid) {
+  unsigned char *out = NULL;
+  int n = host_inflate(data, data_len, method, &out);
+  if (n < 0) { host_enqueue(Q_DECOMPRESS, rid, 0, 0); return; }
+  for (int h = 1; h < HOST_MAX_BLOBS; h++) {
+    if (!host_blobs[h].data) {
+      host_blobs[h] = (host_bytes){ out, n };
+      host_enqueue(Q_DECOMPRESS, rid, h, n);
+      return;
+    }
+  }
+  free(out);
+  host_enqueue(Q_DECOMPRESS, rid, 0, 0);
+}
+
+int ward_js_blob_read(int handle, int blob_offset, int len, void *out) {
+  if (handle <= 0 || handle >= HOST_MAX_BLOBS) return 0;
+  host_bytes *b = &host_blobs[handle];
+  if (!b->data || blob_offset < 0 || blob_offset >= b->len || len <= 0) return 0;
+  int n = b->len - blob_offset < len ? b->len - blob_offset : len;
+  memcpy(out, b->data + blob_offset, (size_t)n);
+  return n;
+}
+
+void ward_js_blob_free(int handle) {
+  if (handle <= 0 || handle >= HOST_MAX_BLOBS) return;
+  free(host_blobs[handle].data);
+  host_blobs[handle].data = NULL;
+}
+
+/* ========== HTML parsing ========== */
+
+int ward_js_parse_html(void *html, int html_len) {
+  unsigned char *sax = NULL;
+  int n = quire_host_html_to_sax(html, html_len, &sax);
+  if (n <= 0) { free(sax); return 0; }
+  ward_bridge_stash_set_int(1, host_stash_put(sax, n));
+  return n;
+}
+
+/* ========== Timers, window, log ========== */
+
+/* Delays are not simulated: the import pipeline only uses timers to
+ * yield for paint, so FIFO order is the observable behavior. */
+void ward_set_timer(int delay_ms, int rid) {
+  (void)delay_ms;
+  host_enqueue(Q_TIMER, rid, 0, 0);
+}
+
+void ward_exit(void) {}
+void ward_js_focus_window(void) {}
+int ward_js_get_visibility_state(void) { return 0; }
+
+void ward_js_log(int level, void *msg, int msg_len) {
+  static const char *labels[4] = { "debug", "info", "warn", "error" };
+  const char *label = level >= 0 && level < 4 ? labels[level] : "log";
+  fprintf(stderr, "[ward:%s] %.*s\n", label, msg_len, (const char *)msg);
+}
+
+/* ========== Quire bridge extensions (index.html extraImports) ========== */
+
+int quire_time_now(void) { return (int)time(NULL); }
+void quire_factory_reset(void) { quire_host_idb_clear(); }
+int quire_get_dark_mode(void) { return 0; }
+int quire_get_input_value(int node_id, int dest_ptr, int dest_max_len) {
+  (void)node_id; (void)dest_ptr; (void)dest_max_len;
+  host_unreachable("quire_get_input_value");
+  return 0;
+}
+void quire_click_node(int node_id) { (void)node_id; host_unreachable("quire_click_node"); }
+void quire_push_history_state(void) {}
+
+/* ========== Browser-only imports ========== */
+
+#define HOST_ABORT(ret, name, ...) \
+  ret name(__VA_ARGS__) { host_unreachable(#name); }
+
+HOST_ABORT(int, ward_js_get_url, void *o, int m)
+HOST_ABORT(int, ward_js_get_url_hash, void *o, int m)
+HOST_ABORT(void, ward_js_set_url_hash, void *h, int l)
+HOST_ABORT(void, ward_js_replace_state, void *u, int l)
+HOST_ABORT(void, ward_js_push_state, void *u, int l)
+HOST_ABORT(int, ward_js_measure_node, int n)
+HOST_ABORT(int, ward_js_query_selector, void *s, int l)
+HOST_ABORT(int, ward_js_caret_position_from_point, int x, int y)
+HOST_ABORT(int, ward_js_read_text_content, int n)
+HOST_ABORT(int, ward_js_measure_text_offset, int n, int o)
+HOST_ABORT(int, ward_js_get_selection_text, void)
+HOST_ABORT(int, ward_js_get_selection_rect, void)
+HOST_ABORT(int, ward_js_get_selection_range, void)
+HOST_ABORT(void, ward_js_add_event_listener, int n, void *t, int l, int id)
+HOST_ABORT(void, ward_js_add_document_event_listener, void *t, int l, int id)
+HOST_ABORT(void, ward_js_remove_event_listener, int id)
+HOST_ABORT(void, ward_js_prevent_default, void)
+HOST_ABORT(void, ward_js_fetch, void *u, int l, int rid)
+HOST_ABORT(void, ward_js_clipboard_write_text, void *t, int l, int rid)
+HOST_ABORT(void, ward_js_notification_request_permission, int rid)
+HOST_ABORT(void, ward_js_notification_show, void *t, int l)
+HOST_ABORT(void, ward_js_push_subscribe, void *v, int l, int rid)
+HOST_ABORT(void, ward_js_push_get_subscription, int rid)
+HOST_ABORT(int, ward_js_create_blob_url, void *d, int dl, void *m, int ml)
+HOST_ABORT(void, ward_js_revoke_blob_url, void *u, int l)
@@ -0,0 +1,67 @@
+/* host_bridge.h -- Native stand-in for the JS bridge (host build only)
+ *
+ * The host build links the ATS parsing core (zip, sha256, xml, epub,
+ * library) against host_bridge.c instead of ward_bridge.mjs. JS
+ * callbacks become entries on a FIFO completion queue; the driver
+ * pumps it with quire_host_drain(), which preserves the browser's
+ * "callback runs after the calling frame returns" ordering.
+ *
+ * Files are loaded whole into memory (the browser's fileCache holds
+ * the full ArrayBuffer too), IDB is an in-memory key/value table, and
+ * decompression is zlib inflate.
+ */
+#ifndef QUIRE_HOST_BRIDGE_H
+#define QUIRE_HOST_BRIDGE_H
+
+/* Register a file on disk as a ward file handle. Returns handle > 0,
+ * or 0 on error. *size_out receives the file size in bytes. */
+int quire_host_file_add(const char *path, int *size_out);
+
+/* Run queued bridge completions until the queue is empty.
+ * Returns the number of completions delivered. */
+int quire_host_drain(void);
+
+/* In-memory IDB: drop all records / report record count and bytes. */
+void quire_host_idb_clear(void);
+int quire_host_idb_count(void);
+long quire_host_idb_bytes(void);
+
+/* HTML -> ward SAX binary (host_html.c). Returns length written to
+ * *out (malloc'd, caller frees), 0 if the document has no body content. */
+int quire_host_html_to_sax(const unsigned char *html, int len,
+                           unsigned char **out);
+
+/* Import driver (host_import.dats). Runs the library_view import
+ * pipeline for an already-open file handle, reporting each phase
+ * through quire_host_mark(). */
+void quire_host_import(int handle, int size);
+
+/* Phase callback implemented by the C driver (host_main.c). */
+void quire_host_mark(int phase, int value);
+
+/* Synchronous IDB read for the benchmarks: stashes a copy of the
+ * record in bridge slot 1 and returns its length, 0 if absent. */
+int quire_host_idb_get_sync(void *key, int key_len);
+
+/* Component benchmarks (host_import.dats). Each runs its component
+ * iters times between quire_host_clock_start/stop (host_main.c), which
+ * accumulate the elapsed time. opf and index need a completed import
+ * and return spine items / chapters run; zip returns entries. */
+void quire_host_bench_sha256(int handle, int size, int iters);
+int quire_host_bench_zip(int handle, int size, int iters);
+int quire_host_bench_opf(int iters);
+int quire_host_bench_index(int iters);
+void quire_host_clock_start(void);
+void quire_host_clock_stop(void);
+
+#define QUIRE_PHASE_START     0
+#define QUIRE_PHASE_HASHED    1  /* value = bytes hashed */
+#define QUIRE_PHASE_ZIP       2  /* value = central directory entries */
+#define QUIRE_PHASE_OPF       3  /* value = spine items */
+#define QUIRE_PHASE_STORED    4  /* value = manifest entries stored */
+#define QUIRE_PHASE_MANIFEST  5  /* value = manifest load result */
+#define QUIRE_PHASE_COVER     6
+#define QUIRE_PHASE_INDEXED   7  /* value = chapters indexed */
+#define QUIRE_PHASE_FAILED    99 /* value = phase that failed */
+
+#endif /* QUIRE_HOST_BRIDGE_H */
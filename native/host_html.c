@@ -0,0 +1,389 @@
+/* host_html.c -- HTML to ward SAX binary for the host build
+ *
+ * Stands in for DOMParser + serializeNode in ward_bridge.mjs so the
+ * search indexer sees the same byte stream natively. Output format:
+ *   ELEMENT_OPEN  [0x01][u8 tag_len][tag][u8 attr_count]
+ *                 per attr: [u8 name_len][name][u16le val_len][val]
+ *   ELEMENT_CLOSE [0x02]
+ *   TEXT          [0x03][u16le len][bytes]
+ *
+ * Mirrors the bridge's filtering: only <body> children are emitted,
+ * script/iframe/object/embed/form/input/link/meta subtrees are dropped,
+ * and attributes named on*, style, or with characters outside
+ * [a-zA-Z0-9-] are skipped. Tag and attribute names are lowercased and
+ * character references decoded, as the HTML parser would.
+ *
+ * This is a tokenizer with an open-element stack, not a full HTML5
+ * tree builder: misnested end tags close back to the nearest match and
+ * unknown end tags are ignored. EPUB content is XHTML, for which the
+ * two agree.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_bridge.h"
+
+typedef struct {
+  unsigned char *buf;
+  int len, cap;
+} sax_out;
+
+static void out_reserve(sax_out *o, int n) {
+  if (o->len + n <= o->cap) return;
+  int cap = o->cap ? o->cap : 4096;
+  while (cap < o->len + n) cap *= 2;
+  o->buf = realloc(o->buf, (size_t)cap);
+  if (!o->buf) abort();
+  o->cap = cap;
+}
+
+static void out_byte(sax_out *o, int b) {
+  out_reserve(o, 1);
+  o->buf[o->len++] = (unsigned char)b;
+}
+
+static void out_bytes(sax_out *o, const unsigned char *p, int n) {
+  out_reserve(o, n);
+  memcpy(o->buf + o->len, p, (size_t)n);
+  o->len += n;
+}
+
+static void out_u16(sax_out *o, int v) {
+  out_byte(o, v & 0xff);
+  out_byte(o, (v >> 8) & 0xff);
+}
+
+static int lower(int c) { return c >= 'A' && c <= 'Z' ? c + 32 : c; }
+
+static int is_space(int c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+static int name_eq(const unsigned char *a, int an, const char *b) {
+  int bn = (int)strlen(b);
+  if (an != bn) return 0;
+  for (int i = 0; i < an; i++) if (lower(a[i]) != b[i]) return 0;
+  return 1;
+}
+
+static int span_eq(const unsigned char *a, const unsigned char *b, int n) {
+  for (int i = 0; i < n; i++) if (lower(a[i]) != lower(b[i])) return 0;
+  return 1;
+}
+
+static int in_set(const unsigned char *n, int len, const char *const *set) {
+  for (; *set; set++) if (name_eq(n, len, *set)) return 1;
+  return 0;
+}
+
+static const char *const filtered_tags[] = {
+  "script", "iframe", "object", "embed", "form", "input", "link", "meta", 0
+};
+static const char *const void_tags[] = {
+  "area", "base", "br", "col", "embed", "hr", "img", "input", "link",
+  "meta", "param", "source", "track", "wbr", 0
+};
+static const char *const raw_text_tags[] = {
+  "script", "style", "textarea", "title", 0
+};
+
+/* ---- character references ---- */
+
+static int put_utf8(unsigned char *d, unsigned cp) {
+  if (cp < 0x80) { d[0] = (unsigned char)cp; return 1; }
+  if (cp < 0x800) {
+    d[0] = (unsigned char)(0xc0 | (cp >> 6));
+    d[1] = (unsigned char)(0x80 | (cp & 0x3f));
+    return 2;
+  }
+  if (cp < 0x10000) {
+    d[0] = (unsigned char)(0xe0 | (cp >> 12));
+    d[1] = (unsigned char)(0x80 | ((cp >> 6) & 0x3f));
+    d[2] = (unsigned char)(0x80 | (cp & 0x3f));
+    return 3;
+  }
+  if (cp > 0x10ffff) cp = 0xfffd;
+  d[0] = (unsigned char)(0xf0 | (cp >> 18));
+  d[1] = (unsigned char)(0x80 | ((cp >> 12) & 0x3f));
+  d[2] = (unsigned char)(0x80 | ((cp >> 6) & 0x3f));
+  d[3] = (unsigned char)(0x80 | (cp & 0x3f));
+  return 4;
+}
+
+static const struct { const char *name; unsigned cp; } named_refs[] = {
+  { "amp", '&' }, { "lt", '<' }, { "gt", '>' }, { "quot", '"' },
+  { "apos", '\'' }, { "nbsp", 0xa0 }, { "shy", 0xad }, { "copy", 0xa9 },
+  { "mdash", 0x2014 }, { "ndash", 0x2013 }, { "hellip", 0x2026 },
+  { "lsquo", 0x2018 }, { "rsquo", 0x2019 }, { "ldquo", 0x201c },
+  { "rdquo", 0x201d }, { 0, 0 }
+};
+
+/* Decode s[0..n) into d (d must hold n bytes: decoding never grows). */
+static int decode_text(const unsigned char *s, int n, unsigned char *d) {
+  int o = 0;
+  for (int i = 0; i < n; ) {
+    if (s[i] != '&') { d[o++] = s[i++]; continue; }
+    int j = i + 1;
+    while (j < n && j - i < 12 && s[j] != ';' && s[j] != '&' && s[j] != '<') j++;
+    if (j >= n || s[j] != ';') { d[o++] = s[i++]; continue; }
+    const unsigned char *r = s + i + 1;
+    int rn = j - i - 1;
+    unsigned cp = 0;
+    int ok = 0;
+    if (rn > 1 && r[0] == '#') {
+      int hex = r[1] == 'x' || r[1] == 'X';
+      ok = rn > 1 + hex;
+      for (int k = 1 + hex; k < rn && ok; k++) {
+        int c = lower(r[k]), v;
+        if (c >= '0' && c <= '9') v = c - '0';
+        else if (hex && c >= 'a' && c <= 'f') v = c - 'a' + 10;
+        else { ok = 0; break; }
+        cp = cp * (hex ? 16u : 10u) + (unsigned)v;
+        if (cp > 0x10ffff) cp = 0xfffd;
+      }
+      if (cp == 0) cp = 0xfffd;
+    } else {
+      for (int k = 0; named_refs[k].name; k++) {
+        if (name_eq(r, rn, named_refs[k].name)) { cp = named_refs[k].cp; ok = 1; break; }
+      }
+    }
+    /* a reference is at least 3 bytes ("&x;"), its UTF-8 at most 4 */
+    if (!ok || (rn + 2 < 4 && cp >= 0x800) || (rn + 2 < 3 && cp >= 0x80)) {
+      d[o++] = s[i++];
+      continue;
+    }
+    o += put_utf8(d + o, cp);
+    i = j + 1;
+  }
+  return o;
+}
+
+/* ---- tree walk state ---- */
+
+#define MAX_DEPTH 256
+
+typedef struct {
+  sax_out out;
+  unsigned char *tmp;          /* decode scratch, sized to the input */
+  const unsigned char *stack[MAX_DEPTH];
+  int stack_len[MAX_DEPTH];
+  int depth;
+  int in_body, in_head;
+  int skip_depth;              /* > 0 while inside a filtered subtree */
+} sax_state;
+
+static void emit_text(sax_state *st, const unsigned char *p, int n) {
+  if (n <= 0 || !st->in_body || st->in_head || st->skip_depth > 0) return;
+  int dn = decode_text(p, n, st->tmp);
+  if (dn == 0 || dn > 65535) return;
+  out_byte(&st->out, 0x03);
+  out_u16(&st->out, dn);
+  out_bytes(&st->out, st->tmp, dn);
+}
+
+static int safe_attr_name(const unsigned char *n, int len) {
+  if (len == 0 || len > 255) return 0;
+  if (len >= 2 && lower(n[0]) == 'o' && lower(n[1]) == 'n') return 0;
+  if (name_eq(n, len, "style")) return 0;
+  for (int i = 0; i < len; i++) {
+    int c = n[i];
+    if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+          (c >= '0' && c <= '9') || c == '-')) return 0;
+  }
+  return 1;
+}
+
+/* Close open elements down to (and including) stack index k. */
+static void close_to(sax_state *st, int k) {
+  while (st->depth > k) {
+    st->depth--;
+    if (st->skip_depth > 0) {
+      st->skip_depth--;
+    } else if (st->in_body) {
+      out_byte(&st->out, 0x02);
+    }
+  }
+}
+
+static void end_tag(sax_state *st, const unsigned char *n, int len) {
+  if (name_eq(n, len, "head")) { st->in_head = 0; return; }
+  if (name_eq(n, len, "body") || name_eq(n, len, "html")) {
+    close_to(st, 0);
+    st->in_body = 0;
+    return;
+  }
+  for (int k = st->depth - 1; k >= 0; k--) {
+    if (st->stack_len[k] == len && span_eq(st->stack[k], n, len)) {
+      close_to(st, k);
+      return;
+    }
+  }
+}
+
+/* Parse a start tag whose name begins at s[i]. Returns index after '>'. */
+static int start_tag(sax_state *st, const unsigned char *s, int n, int i) {
+  int ns = i;
+  while (i < n && !is_space(s[i]) && s[i] != '>' && s[i] != '/') i++;
+  const unsigned char *name = s + ns;
+  int name_len = i - ns;
+
+  /* attributes: record spans, emit after deciding whether to keep tag */
+  enum { MAX_ATTRS = 255 };
+  int an[MAX_ATTRS], al[MAX_ATTRS], vs[MAX_ATTRS], vl[MAX_ATTRS];
+  int nattr = 0, self_close = 0;
+  while (i < n && s[i] != '>') {
+    if (is_space(s[i])) { i++; continue; }
+    if (s[i] == '/') { self_close = 1; i++; continue; }
+    self_close = 0;
+    int a0 = i;
+    while (i < n && !is_space(s[i]) && s[i] != '=' && s[i] != '>' && s[i] != '/') i++;
+    int alen = i - a0, v0 = i, vlen = 0;
+    while (i < n && is_space(s[i])) i++;
+    if (i < n && s[i] == '=') {
+      i++;
+      while (i < n && is_space(s[i])) i++;
+      if (i < n && (s[i] == '"' || s[i] == '\'')) {
+        int q = s[i++];
+        v0 = i;
+        while (i < n && s[i] != q) i++;
+        vlen = i - v0;
+        if (i < n) i++;
+      } else {
+        v0 = i;
+        while (i < n && !is_space(s[i]) && s[i] != '>') i++;
+        vlen = i - v0;
+      }
+    }
+    if (alen > 0 && nattr < MAX_ATTRS) {
+      an[nattr] = a0; al[nattr] = alen; vs[nattr] = v0; vl[nattr] = vlen;
+      nattr++;
+    }
+  }
+  if (i < n) i++; /* '>' */
+
+  if (name_eq(name, name_len, "html")) return i;
+  if (name_eq(name, name_len, "head")) { st->in_head = 1; return i; }
+  if (name_eq(name, name_len, "body")) {
+    st->in_head = 0;
+    st->in_body = 1;
+    return i;
+  }
+
+  int is_void = in_set(name, name_len, void_tags);
+  int is_raw = in_set(name, name_len, raw_text_tags);
+  int raw_end = i;
+
+  /* raw text: content runs to the matching end tag */
+  if (is_raw) {
+    int j = i;
+    while (j + 2 + name_len <= n &&
+           !(s[j] == '<' && s[j + 1] == '/' &&
+             span_eq(s + j + 2, name, name_len)))
+      j++;
+    raw_end = j + 2 + name_len <= n ? j : n;
+  }
+
+  int keep = st->in_body && !st->in_head;
+  if (keep && (st->skip_depth > 0 || in_set(name, name_len, filtered_tags)
+               || name_len > 255 || name_len == 0)) {
+    if (!is_void && !self_close && st->depth < MAX_DEPTH) {
+      st->stack[st->depth] = name;
+      st->stack_len[st->depth] = name_len;
+      st->depth++;
+      st->skip_depth++;
+    }
+    keep = 0;
+  } else if (keep) {
+    int nsafe = 0;
+    for (int a = 0; a < nattr; a++)
+      if (safe_attr_name(s + an[a], al[a])) nsafe++;
+    out_byte(&st->out, 0x01);
+    out_byte(&st->out, name_len);
+    for (int k = 0; k < name_len; k++) out_byte(&st->out, lower(name[k]));
+    int count_at = st->out.len;
+    out_byte(&st->out, nsafe);
+    int written = 0;
+    for (int a = 0; a < nattr; a++) {
+      if (!safe_attr_name(s + an[a], al[a])) continue;
+      int dn = decode_text(s + vs[a], vl[a], st->tmp);
+      if (dn > 65535) continue;
+      out_byte(&st->out, al[a]);
+      for (int k = 0; k < al[a]; k++) out_byte(&st->out, lower(s[an[a] + k]));
+      out_u16(&st->out, dn);
+      out_bytes(&st->out, st->tmp, dn);
+      written++;
+    }
+    st->out.buf[count_at] = (unsigned char)written;
+
+    if (is_void || self_close) {
+      out_byte(&st->out, 0x02);
+    } else if (st->depth < MAX_DEPTH) {
+      st->stack[st->depth] = name;
+      st->stack_len[st->depth] = name_len;
+      st->depth++;
+    } else {
+      out_byte(&st->out, 0x02); /* too deep: flatten */
+    }
+  }
+
+  if (is_raw) {
+    if (keep && !is_void && !self_close) emit_text(st, s + i, raw_end - i);
+    i = raw_end;
+  }
+  return i;
+}
+
+int quire_host_html_to_sax(const unsigned char *s, int n, unsigned char **out) {
+  sax_state st;
+  memset(&st, 0, sizeof st);
+  st.tmp = malloc((size_t)(n > 0 ? n : 1));
+  if (!st.tmp) abort();
+
+  /* Documents without a <body> tag get an implied one, as DOMParser does */
+  int has_body = 0;
+  for (int i = 0; i + 5 <= n; i++) {
+    if (s[i] == '<' && name_eq(s + i + 1, 4, "body")) { has_body = 1; break; }
+  }
+  st.in_body = !has_body;
+
+  int i = 0, text0 = 0;
+  while (i < n) {
+    if (s[i] != '<') { i++; continue; }
+    int c = i + 1 < n ? s[i + 1] : 0;
+    if (c == '!' || c == '?' || c == '/' ||
+        (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+      emit_text(&st, s + text0, i - text0);
+    } else {
+      i++;
+      continue;
+    }
+    if (c == '!' && i + 3 < n && s[i + 2] == '-' && s[i + 3] == '-') {
+      int j = i + 4;
+      while (j + 2 < n && !(s[j] == '-' && s[j + 1] == '-' && s[j + 2] == '>')) j++;
+      i = j + 2 < n ? j + 3 : n;
+    } else if (c == '!' && i + 9 <= n && memcmp(s + i, "<![CDATA[", 9) == 0) {
+      int j = i + 9;
+      while (j + 2 < n && !(s[j] == ']' && s[j + 1] == ']' && s[j + 2] == '>')) j++;
+      emit_text(&st, s + i + 9, (j < n ? j : n) - (i + 9));
+      i = j + 2 < n ? j + 3 : n;
+    } else if (c == '!' || c == '?') {
+      while (i < n && s[i] != '>') i++;
+      if (i < n) i++;
+    } else if (c == '/') {
+      int j = i + 2, ns = j;
+      while (j < n && !is_space(s[j]) && s[j] != '>') j++;
+      end_tag(&st, s + ns, j - ns);
+      while (j < n && s[j] != '>') j++;
+      i = j < n ? j + 1 : n;
+    } else {
+      i = start_tag(&st, s, n, i + 1);
+    }
+    text0 = i;
+  }
+  emit_text(&st, s + text0, n - text0);
+  close_to(&st, 0);
+
+  free(st.tmp);
+  *out = st.out.buf;
+  return st.out.len;
+}
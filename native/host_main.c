@@ -0,0 +1,171 @@
+/* host_main.c -- quire-host: native EPUB import driver and benchmarks
+ *
+ *   quire-host book.epub...          import each book once, print summary
+ *   quire-host -n 20 book.epub...    repeat each import 20 times, then
+ *                                    benchmark each component 20 times
+ *
+ * Every import runs the full pipeline (quire_host_import) against a
+ * fresh in-memory IDB; its end-to-end time is reported on its own line.
+ * The component figures come from the quire_host_bench_* loops, which
+ * call each component directly with its input already in memory, so
+ * they exclude promise, IDB and zlib overhead:
+ *   sha256   MB/s hashed
+ *   zip      central-directory entries/s parsed (EOCD, CD, path index)
+ *   opf      spine items/s extracted from the OPF (metadata, manifest,
+ *            spine)
+ *   index    chapters/s of search text extracted from chapter SAX
+ *
+ * Intended to be run under perf, valgrind or an -fsanitize build; see
+ * the host targets in the Makefile.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "host_bridge.h"
+
+void quire_host_init(void);
+void ward_js_file_close(int handle);
+
+#define NPHASE 8
+
+static double phase_t[NPHASE];
+static int phase_v[NPHASE];
+static int failed_at;
+static long stored_bytes;   /* IDB bytes at PHASE_STORED: resources only */
+
+static double now_sec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Benchmark clock, driven from the quire_host_bench_* loops */
+static double clock_t0, clock_acc;
+
+void quire_host_clock_start(void) { clock_t0 = now_sec(); }
+void quire_host_clock_stop(void) { clock_acc += now_sec() - clock_t0; }
+
+void quire_host_mark(int phase, int value) {
+  if (phase == QUIRE_PHASE_FAILED) { failed_at = value; return; }
+  if (phase < 0 || phase >= NPHASE) return;
+  phase_t[phase] = now_sec();
+  phase_v[phase] = value;
+  if (phase == QUIRE_PHASE_STORED) stored_bytes = quire_host_idb_bytes();
+}
+
+typedef struct {
+  double t_import;       /* summed seconds, PHASE_START to PHASE_INDEXED */
+  double stored_bytes;
+  int runs;
+} bench_acc;
+
+/* Returns 0 on success, else the phase that failed. */
+static int run_import(int handle, int size) {
+  memset(phase_t, 0, sizeof phase_t);
+  memset(phase_v, 0, sizeof phase_v);
+  failed_at = 0;
+  quire_host_idb_clear();
+  quire_host_import(handle, size);
+  quire_host_drain();
+  if (failed_at) return failed_at;
+  if (phase_t[QUIRE_PHASE_INDEXED] == 0.0) return QUIRE_PHASE_INDEXED;
+  return 0;
+}
+
+static void accumulate(bench_acc *a) {
+  a->t_import += phase_t[QUIRE_PHASE_INDEXED] - phase_t[QUIRE_PHASE_START];
+  a->stored_bytes += (double)stored_bytes;
+  a->runs++;
+}
+
+static double rate(double n, double t) { return t > 0.0 ? n / t : 0.0; }
+
+/* One component line: rate of n units over the clock, ms per iteration */
+static void report_component(const char *name, const char *unit,
+                             double n, int iters) {
+  printf("  %-7s %10.2f %-11s %8.3f ms\n", name, rate(n, clock_acc), unit,
+         clock_acc * 1e3 / iters);
+}
+
+/* Runs after the last import: the index and opf loops read its
+ * manifest and IDB records. index goes first since the opf loop
+ * re-parses the OPF into the spine tables it walks. */
+static void report(const char *path, const bench_acc *a,
+                   int handle, int size, int iters) {
+  const double mb = 1024.0 * 1024.0;
+  printf("%s (%d run%s)\n", path, a->runs, a->runs == 1 ? "" : "s");
+  printf("  import  %10.2f MB/s       %8.3f ms  end to end, %.2f MB stored\n",
+         rate((double)size * a->runs / mb, a->t_import),
+         a->t_import * 1e3 / a->runs, a->stored_bytes / a->runs / mb);
+
+  clock_acc = 0.0;
+  int chapters = quire_host_bench_index(iters);
+  report_component("index", "chapters/s", (double)chapters * iters, iters);
+
+  clock_acc = 0.0;
+  int items = quire_host_bench_opf(iters);
+  report_component("opf", "items/s", (double)items * iters, iters);
+
+  clock_acc = 0.0;
+  int entries = quire_host_bench_zip(handle, size, iters);
+  report_component("zip", "entries/s", (double)entries * iters, iters);
+
+  clock_acc = 0.0;
+  quire_host_bench_sha256(handle, size, iters);
+  report_component("sha256", "MB/s", (double)size * iters / mb, iters);
+}
+
+static void usage(void) {
+  fprintf(stderr, "usage: quire-host [-n iterations] book.epub...\n");
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  int iters = 1, bench = 0, status = 0, i = 1;
+  if (i < argc && strcmp(argv[i], "-n") == 0) {
+    if (i + 1 >= argc) usage();
+    iters = atoi(argv[i + 1]);
+    if (iters <= 0) usage();
+    bench = 1;
+    i += 2;
+  }
+  if (i >= argc) usage();
+
+  quire_host_init();
+
+  for (; i < argc; i++) {
+    int size = 0;
+    int handle = quire_host_file_add(argv[i], &size);
+    if (!handle) {
+      fprintf(stderr, "%s: cannot read\n", argv[i]);
+      status = 1;
+      continue;
+    }
+    bench_acc acc;
+    memset(&acc, 0, sizeof acc);
+    for (int k = 0; k < iters; k++) {
+      int rc = run_import(handle, size);
+      if (rc) {
+        fprintf(stderr, "%s: import failed at phase %d\n", argv[i], rc);
+        status = 1;
+        break;
+      }
+      accumulate(&acc);
+    }
+    if (acc.runs > 0) {
+      if (bench) {
+        report(argv[i], &acc, handle, size, iters);
+      } else {
+        printf("%s: %d entries, %d chapters, %d IDB records (%ld bytes), %.3f ms\n",
+               argv[i], phase_v[QUIRE_PHASE_ZIP], phase_v[QUIRE_PHASE_INDEXED],
+               quire_host_idb_count(), quire_host_idb_bytes(),
+               (phase_t[QUIRE_PHASE_INDEXED] - phase_t[QUIRE_PHASE_START]) * 1e3);
+      }
+    }
+    ward_js_file_close(handle);
+  }
+  quire_host_idb_clear();
+  return status;
+}
@@ -0,0 +1,38 @@
+/* host_runtime.h -- Native host prelude for the quire parsing core
+ *
+ * Force-included (-include) in place of ward's runtime.h when the
+ * ATS-generated C is compiled for x86_64 Linux instead of wasm32.
+ * Reuses runtime.h verbatim so the instruction macros, promise field
+ * layout and closure helpers are byte-for-byte the ones WASM runs.
+ *
+ * runtime.h declares malloc/free/memset/memcpy with wasm32 signatures
+ * (int sizes). Those names are redirected to quire_host_* forwarders
+ * (host_bridge.c) so the generated code never sees a conflicting libc
+ * prototype, while every allocation still lands in libc malloc where
+ * valgrind and the sanitizers can track it.
+ *
+ * runtime.h only declares ward's imports. quire's own (quire_ext.sats,
+ * "mac#") are declared below: the host build makes implicit
+ * declarations an error, since on LP64 they would return a truncated
+ * int.
+ */
+#ifndef QUIRE_HOST_RUNTIME_H
+#define QUIRE_HOST_RUNTIME_H
+
+#define malloc quire_host_malloc
+#define free quire_host_free
+#define memset quire_host_memset
+#define memcpy quire_host_memcpy
+#define calloc quire_host_calloc
+
+#include "../vendor/ward/lib/runtime.h"
+
+/* quire_ext.sats imports (host_bridge.c) */
+int quire_time_now(void);
+void quire_factory_reset(void);
+int quire_get_dark_mode(void);
+int quire_get_input_value(int node_id, int dest_ptr, int dest_max_len);
+void quire_click_node(int node_id);
+void quire_push_history_state(void);
+
+#endif /* QUIRE_HOST_RUNTIME_H */
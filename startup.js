@@ -0,0 +1,269 @@
+/**
+ * Startup fast path
+ *
+ * Two things stand between a launch and a usable screen: compiling
+ * quire.wasm, and ward_node_init loading the library from IDB, rendering
+ * it and fetching every cover. This module shortens both:
+ *
+ * - compileQuireModule streams the compile (compileStreaming lets the
+ *   engine start on the first bytes and reuse its own code cache for
+ *   the service-worker copy). It also keeps the compiled
+ *   WebAssembly.Module in IndexedDB on platforms that can
+ *   structured-clone one. The IDB lookup runs alongside the compile,
+ *   never ahead of it, and a platform that once failed to store a
+ *   module is remembered and skips IDB from then on.
+ * - saveLibrarySnapshot keeps the last rendered library view in
+ *   localStorage, with small data-URL thumbnails standing in for the
+ *   covers. paintLibrarySnapshot paints it in place of the loading
+ *   spinner on the next launch, before the module has even been fetched.
+ *   The snapshot is inert. The engine's first render replaces it, which
+ *   reconciles it with the real library.
+ * - watchInteractive reports when the engine's own view is on screen.
+ *
+ * The app-specific parts are the selectors of the two top-level views.
+ */
+
+const MODULE_DB = 'quire-startup';
+const MODULE_STORE = 'modules';
+const MODULE_KEY = 'quire.wasm';
+// localStorage flag: this platform can't persist a compiled module
+export const MODULE_CACHE_OFF_KEY = 'quire-module-cache-off';
+
+export const SNAPSHOT_KEY = 'quire-library-snapshot';
+const SNAPSHOT_VERSION = 1;
+const SNAPSHOT_MAX_CHARS = 512 * 1024;
+// Cover thumbnails: height in px, and their share of SNAPSHOT_MAX_CHARS
+const THUMB_HEIGHT = 96;
+const THUMB_BUDGET_CHARS = 256 * 1024;
+const THUMB_ATTR = 'data-snapshot-src';
+
+const SNAPSHOT_CLASS = 'quire-snapshot';
+const LIBRARY_SELECTOR = '.library-list';
+const READER_SELECTOR = '.reader-viewport';
+
+// --- Compiled module cache ---
+
+function openModuleDb() {
+  return new Promise((resolve, reject) => {
+    const req = indexedDB.open(MODULE_DB, 1);
+    req.onupgradeneeded = () => req.result.createObjectStore(MODULE_STORE);
+    req.onsuccess = () => resolve(req.result);
+    req.onerror = () => reject(req.error);
+  });
+}
+
+function idbRequest(db, mode, op) {
+  return new Promise((resolve, reject) => {
+    const tx = db.transaction(MODULE_STORE, mode);
+    const req = op(tx.objectStore(MODULE_STORE));
+    tx.oncomplete = () => resolve(req.result);
+    tx.onerror = () => reject(tx.error);
+    tx.onabort = () => reject(tx.error);
+  });
+}
+
+/** Cached module for this build, or null. */
+export async function loadCachedModule(version) {
+  try {
+    const db = await openModuleDb();
+    try {
+      const entry = await idbRequest(db, 'readonly', s => s.get(MODULE_KEY));
+      if (entry && entry.version === version &&
+          entry.module instanceof WebAssembly.Module) {
+        return entry.module;
+      }
+      return null;
+    } finally {
+      db.close();
+    }
+  } catch (e) {
+    return null;
+  }
+}
+
+/** Persist a compiled module. Returns false where modules can't be cloned. */
+export async function storeCachedModule(version, module) {
+  try {
+    const db = await openModuleDb();
+    try {
+      await idbRequest(db, 'readwrite', s => s.put({ version, module }, MODULE_KEY));
+      return true;
+    } finally {
+      db.close();
+    }
+  } catch (e) {
+    return false;
+  }
+}
+
+async function compileFromNetwork(url) {
+  try {
+    return await WebAssembly.compileStreaming(fetch(url));
+  } catch (e) {
+    // No streaming support, or a server without application/wasm
+    const resp = await fetch(url);
+    return WebAssembly.compile(await resp.arrayBuffer());
+  }
+}
+
+function moduleCacheOff(storage) {
+  try {
+    return storage.getItem(MODULE_CACHE_OFF_KEY) !== null;
+  } catch (e) {
+    return true;
+  }
+}
+
+/**
+ * Compile quire.wasm for this build.
+ * `version` is the build stamp; "dev" builds change without a version
+ * bump, so their modules are never persisted. The network compile
+ * starts at once; a cached module is used only if the lookup answers
+ * before the compile finishes.
+ */
+export async function compileQuireModule(url, version, storage = localStorage) {
+  const persist = version && version !== 'dev' && !moduleCacheOff(storage);
+  const compiled = compileFromNetwork(url);
+  if (!persist) return compiled;
+  // A cache hit leaves the compile to finish unused; don't let its
+  // failure surface as an unhandled rejection
+  compiled.catch(() => {});
+  const lookup = loadCachedModule(version);
+  const cached = await Promise.race([lookup, compiled.then(() => null, () => null)]);
+  if (cached) return cached;
+  let module;
+  try {
+    module = await compiled;
+  } catch (e) {
+    const hit = await lookup;
+    if (hit) return hit;
+    throw e;
+  }
+  lookup
+    .then(hit => hit !== null || storeCachedModule(version, module))
+    .then(ok => {
+      if (!ok) storage.setItem(MODULE_CACHE_OFF_KEY, '1');
+    })
+    .catch(() => {});
+  return module;
+}
+
+// --- Library snapshot ---
+
+// Set by clearLibrarySnapshot: nothing is saved for the rest of this page
+let snapshotCleared = false;
+
+/** JPEG data URL of a loaded image scaled to THUMB_HEIGHT, or null. */
+function coverThumbnail(img) {
+  try {
+    if (!img.complete || !img.naturalWidth || !img.naturalHeight) return null;
+    const canvas = img.ownerDocument.createElement('canvas');
+    const h = Math.min(THUMB_HEIGHT, img.naturalHeight);
+    canvas.height = h;
+    canvas.width = Math.max(1, Math.round(img.naturalWidth * h / img.naturalHeight));
+    const ctx = canvas.getContext('2d');
+    if (!ctx) return null;
+    ctx.drawImage(img, 0, 0, canvas.width, canvas.height);
+    const url = canvas.toDataURL('image/jpeg', 0.7);
+    return url.startsWith('data:image/') ? url : null;
+  } catch (e) {
+    return null;
+  }
+}
+
+/**
+ * Record the library view currently under root.
+ * Cover images are blob URLs that die with the page, so their src is
+ * dropped. Each loaded cover is kept instead as a thumbnail in a data
+ * attribute, until the thumbnails' budget runs out; covers without one
+ * keep their box size. If the reader is showing, the engine will open
+ * the book again on launch, so the snapshot is cleared rather than
+ * flashing the library first.
+ */
+export function saveLibrarySnapshot(root, storage = localStorage) {
+  try {
+    if (snapshotCleared) return false;
+    if (root.querySelector('.' + SNAPSHOT_CLASS)) return false;
+    if (root.querySelector(READER_SELECTOR) || !root.querySelector(LIBRARY_SELECTOR)) {
+      storage.removeItem(SNAPSHOT_KEY);
+      return false;
+    }
+    const copy = root.cloneNode(true);
+    const live = root.querySelectorAll('img');
+    let budget = THUMB_BUDGET_CHARS;
+    copy.querySelectorAll('img').forEach((img, i) => {
+      img.removeAttribute('src');
+      img.removeAttribute('srcset');
+      const thumb = live[i] ? coverThumbnail(live[i]) : null;
+      if (thumb && thumb.length <= budget) {
+        img.setAttribute(THUMB_ATTR, thumb);
+        budget -= thumb.length;
+      }
+    });
+    const html = copy.innerHTML;
+    if (html.length > SNAPSHOT_MAX_CHARS) {
+      storage.removeItem(SNAPSHOT_KEY);
+      return false;
+    }
+    storage.setItem(SNAPSHOT_KEY, JSON.stringify({ v: SNAPSHOT_VERSION, html }));
+    return true;
+  } catch (e) {
+    return false;
+  }
+}
+
+/** Drop the snapshot and stop saving one (e.g. before a factory reset). */
+export function clearLibrarySnapshot(storage = localStorage) {
+  snapshotCleared = true;
+  try {
+    storage.removeItem(SNAPSHOT_KEY);
+  } catch (e) {}
+}
+
+/** Paint the saved library view into root. Returns true if painted. */
+export function paintLibrarySnapshot(root, storage = localStorage) {
+  try {
+    const raw = storage.getItem(SNAPSHOT_KEY);
+    if (!raw) return false;
+    const snap = JSON.parse(raw);
+    if (!snap || snap.v !== SNAPSHOT_VERSION || typeof snap.html !== 'string') {
+      return false;
+    }
+    const doc = root.ownerDocument;
+    const wrap = doc.createElement('div');
+    wrap.className = SNAPSHOT_CLASS;
+    wrap.style.display = 'contents';  // layout as if its children were root's
+    wrap.setAttribute('inert', '');
+    wrap.setAttribute('aria-busy', 'true');
+    wrap.innerHTML = snap.html;
+    for (const img of wrap.querySelectorAll('img[' + THUMB_ATTR + ']')) {
+      const thumb = img.getAttribute(THUMB_ATTR);
+      img.removeAttribute(THUMB_ATTR);
+      if (thumb.startsWith('data:image/')) img.setAttribute('src', thumb);
+    }
+    root.replaceChildren(wrap);
+    return true;
+  } catch (e) {
+    return false;
+  }
+}
+
+// --- Time to interactive ---
+
+/** The engine's view (not the snapshot or spinner) is under root. */
+export function isEngineViewShown(root) {
+  return !root.querySelector('.' + SNAPSHOT_CLASS) &&
+    !!root.querySelector(LIBRARY_SELECTOR + ', ' + READER_SELECTOR);
+}
+
+/** Call onReady once the engine has rendered its first view. */
+export function watchInteractive(root, onReady) {
+  const win = root.ownerDocument.defaultView;
+  const observer = new win.MutationObserver(() => {
+    if (!isEngineViewShown(root)) return;
+    observer.disconnect();
+    onReady();
+  });
+  observer.observe(root, { childList: true, subtree: true });
+  return observer;
+}
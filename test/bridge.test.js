@@ -1494,3 +1494,41 @@ describe('IndexedDB Key-Value Store', () => {
     });
   });
 });
+
+describe('loadWard', () => {
+  // Smallest module loadWard can start: exports memory and a
+  // ward_node_init that stores 7 at address 0
+  const name = (s) => [s.length, ...new TextEncoder().encode(s)];
+  const WASM = new Uint8Array([
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    0x01, 0x05, 0x01, 0x60, 0x01, 0x7f, 0x00,
+    0x03, 0x02, 0x01, 0x00,
+    0x05, 0x03, 0x01, 0x00, 0x01,
+    0x07, 0x1b, 0x02, ...name('memory'), 0x02, 0x00,
+    ...name('ward_node_init'), 0x00, 0x00,
+    0x0a, 0x0b, 0x01, 0x09, 0x00,
+    0x41, 0x00, 0x41, 0x07, 0x36, 0x02, 0x00, 0x0b
+  ]);
+  let loadWard;
+
+  beforeEach(async () => {
+    ({ loadWard } = await import('../vendor/ward/lib/ward_bridge.mjs'));
+    document.body.innerHTML = '<div id="ward-root"></div>';
+  });
+
+  it('should instantiate from bytes and call ward_node_init', async () => {
+    const root = document.getElementById('ward-root');
+    const { exports, nodes } = await loadWard(WASM, root);
+    expect(new Uint8Array(exports.memory.buffer)[0]).toBe(7);
+    expect(nodes.get(0)).toBe(root);
+  });
+
+  it('should instantiate a precompiled WebAssembly.Module', async () => {
+    const root = document.getElementById('ward-root');
+    const module = await WebAssembly.compile(WASM);
+    const { exports, nodes } = await loadWard(module, root);
+    expect(exports.memory).toBeInstanceOf(WebAssembly.Memory);
+    expect(new Uint8Array(exports.memory.buffer)[0]).toBe(7);
+    expect(nodes.get(0)).toBe(root);
+  });
+});
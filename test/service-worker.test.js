@@ -23,6 +23,7 @@ describe('Service Worker Source', () => {
   it('should define SHELL with all app shell assets', () => {
     expect(swSource).toContain("'./'");
     expect(swSource).toContain("'ward_bridge.js'");
+    expect(swSource).toContain("'startup.js'");
     expect(swSource).toContain("'quire.wasm'");
     expect(swSource).toContain("'reader.css'");
     expect(swSource).toContain("'manifest.json'");
@@ -96,7 +97,8 @@ describe('Service Worker Behavior', () => {
 
     expect(mockCaches.open).toHaveBeenCalledWith('quire-v4');
     expect(mockCache.addAll).toHaveBeenCalledWith([
-      './', 'ward_bridge.js', 'quire.wasm', 'reader.css', 'manifest.json',
+      './', 'ward_bridge.js', 'startup.js', 'quire.wasm', 'reader.css',
+      'manifest.json',
       'assets/fonts/literata-latin.woff2',
       'assets/fonts/literata-italic-latin.woff2',
       'assets/fonts/inter-latin.woff2',
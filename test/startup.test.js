@@ -0,0 +1,235 @@
+/**
+ * Startup fast path tests
+ *
+ * Tests startup.js against jsdom and fake IndexedDB.
+ * Validates:
+ * - Library snapshot save (covers stripped, cleared while reading)
+ * - Cover thumbnails kept in the snapshot and restored on paint
+ * - Snapshot paint (inert, replaces spinner, rejects bad data)
+ * - Interactive detection once the engine replaces the snapshot
+ * - Compiled module cache keyed by build version
+ * - Module compile not held up by the cache lookup; cache skipped on
+ *   platforms that failed to store a module
+ */
+
+import { describe, it, expect, beforeEach, afterEach, vi } from 'vitest';
+import { JSDOM } from 'jsdom';
+import { indexedDB, IDBKeyRange } from 'fake-indexeddb';
+
+const dom = new JSDOM('<!DOCTYPE html><html><body></body></html>', {
+  url: 'http://localhost'
+});
+global.document = dom.window.document;
+global.window = dom.window;
+global.indexedDB = indexedDB;
+global.IDBKeyRange = IDBKeyRange;
+
+const {
+  SNAPSHOT_KEY,
+  saveLibrarySnapshot,
+  paintLibrarySnapshot,
+  isEngineViewShown,
+  watchInteractive,
+  loadCachedModule,
+  storeCachedModule,
+  compileQuireModule,
+  MODULE_CACHE_OFF_KEY,
+} = await import('../startup.js');
+
+function memoryStorage() {
+  const m = new Map();
+  return {
+    getItem: k => (m.has(k) ? m.get(k) : null),
+    setItem: (k, v) => { m.set(k, String(v)); },
+    removeItem: k => { m.delete(k); },
+  };
+}
+
+function libraryView(root) {
+  root.innerHTML =
+    '<style>.book-card{display:flex}</style>' +
+    '<div class="library-list">' +
+    '<div class="book-card"><img class="book-cover" src="blob:http://localhost/1">' +
+    '<div class="book-title">First</div><div class="book-position">Ch 2</div></div>' +
+    '<div class="book-card"><div class="book-title">Second</div>' +
+    '<div class="book-position">New</div></div>' +
+    '</div>';
+}
+
+// Minimal valid module: magic + version
+const EMPTY_WASM = new Uint8Array([0, 97, 115, 109, 1, 0, 0, 0]);
+
+describe('Library snapshot', () => {
+  let root;
+  let storage;
+
+  beforeEach(() => {
+    document.body.innerHTML =
+      '<div id="app"><div class="quire-loading"><div class="spinner"></div></div></div>';
+    root = document.getElementById('app');
+    storage = memoryStorage();
+  });
+
+  it('should save the library view without cover blob URLs', () => {
+    libraryView(root);
+    expect(saveLibrarySnapshot(root, storage)).toBe(true);
+
+    const snap = JSON.parse(storage.getItem(SNAPSHOT_KEY));
+    expect(snap.html).toContain('First');
+    expect(snap.html).toContain('Ch 2');
+    expect(snap.html).toContain('book-cover');
+    expect(snap.html).not.toContain('blob:');
+    // The live view is untouched
+    expect(root.querySelector('img').getAttribute('src')).toContain('blob:');
+  });
+
+  it('should keep loaded covers as thumbnails and paint them', () => {
+    const THUMB = 'data:image/jpeg;base64,/9j/AAAA';
+    const Canvas = dom.window.HTMLCanvasElement.prototype;
+    const getContext = vi.spyOn(Canvas, 'getContext')
+      .mockReturnValue({ drawImage() {} });
+    const toDataURL = vi.spyOn(Canvas, 'toDataURL').mockReturnValue(THUMB);
+    try {
+      const src = document.createElement('div');
+      libraryView(src);
+      const img = src.querySelector('img');
+      Object.defineProperty(img, 'complete', { value: true });
+      Object.defineProperty(img, 'naturalWidth', { value: 600 });
+      Object.defineProperty(img, 'naturalHeight', { value: 900 });
+      expect(saveLibrarySnapshot(src, storage)).toBe(true);
+
+      const snap = JSON.parse(storage.getItem(SNAPSHOT_KEY));
+      expect(snap.html).not.toContain('blob:');
+      expect(snap.html).toContain(THUMB);
+
+      expect(paintLibrarySnapshot(root, storage)).toBe(true);
+      const painted = root.querySelector('.quire-snapshot img');
+      expect(painted.getAttribute('src')).toBe(THUMB);
+      expect(painted.hasAttribute('data-snapshot-src')).toBe(false);
+    } finally {
+      getContext.mockRestore();
+      toDataURL.mockRestore();
+    }
+  });
+
+  it('should clear the snapshot while the reader is showing', () => {
+    libraryView(root);
+    saveLibrarySnapshot(root, storage);
+    root.innerHTML = '<div class="reader-viewport"></div>';
+
+    expect(saveLibrarySnapshot(root, storage)).toBe(false);
+    expect(storage.getItem(SNAPSHOT_KEY)).toBeNull();
+  });
+
+  it('should paint the snapshot inert in place of the spinner', () => {
+    const src = document.createElement('div');
+    libraryView(src);
+    saveLibrarySnapshot(src, storage);
+
+    expect(paintLibrarySnapshot(root, storage)).toBe(true);
+    expect(root.querySelector('.quire-loading')).toBeNull();
+    const wrap = root.querySelector('.quire-snapshot');
+    expect(wrap.hasAttribute('inert')).toBe(true);
+    expect(wrap.querySelectorAll('.book-card')).toHaveLength(2);
+    expect(isEngineViewShown(root)).toBe(false);
+  });
+
+  it('should not re-save a painted snapshot', () => {
+    const src = document.createElement('div');
+    libraryView(src);
+    saveLibrarySnapshot(src, storage);
+    const saved = storage.getItem(SNAPSHOT_KEY);
+    paintLibrarySnapshot(root, storage);
+
+    expect(saveLibrarySnapshot(root, storage)).toBe(false);
+    expect(storage.getItem(SNAPSHOT_KEY)).toBe(saved);
+  });
+
+  it('should ignore missing, corrupt or old-version snapshots', () => {
+    expect(paintLibrarySnapshot(root, storage)).toBe(false);
+    storage.setItem(SNAPSHOT_KEY, '{not json');
+    expect(paintLibrarySnapshot(root, storage)).toBe(false);
+    storage.setItem(SNAPSHOT_KEY, JSON.stringify({ v: 0, html: '<p>x</p>' }));
+    expect(paintLibrarySnapshot(root, storage)).toBe(false);
+    expect(root.querySelector('.quire-loading')).not.toBeNull();
+  });
+
+  it('should report interactive once the engine replaces the snapshot', async () => {
+    const src = document.createElement('div');
+    libraryView(src);
+    saveLibrarySnapshot(src, storage);
+
+    let ready = 0;
+    watchInteractive(root, () => { ready++; });
+    paintLibrarySnapshot(root, storage);
+    await new Promise(r => setTimeout(r, 0));
+    expect(ready).toBe(0);
+
+    // Engine render: remove_children(root), then its own view
+    root.replaceChildren();
+    libraryView(root);
+    await new Promise(r => setTimeout(r, 0));
+    expect(ready).toBe(1);
+    expect(isEngineViewShown(root)).toBe(true);
+  });
+});
+
+describe('Compiled module cache', () => {
+  it('should return null when nothing is cached', async () => {
+    expect(await loadCachedModule('abc1234')).toBeNull();
+  });
+
+  it('should only return a module stored for the same version', async () => {
+    const module = new WebAssembly.Module(EMPTY_WASM);
+    const stored = await storeCachedModule('abc1234', module);
+    if (!stored) return;  // platform can't clone modules — nothing to load
+
+    expect(await loadCachedModule('abc1234')).toBeInstanceOf(WebAssembly.Module);
+    expect(await loadCachedModule('def5678')).toBeNull();
+  });
+});
+
+describe('Module compile', () => {
+  let storage;
+
+  beforeEach(() => {
+    storage = memoryStorage();
+    global.fetch = vi.fn(async () => ({}));
+    vi.spyOn(WebAssembly, 'compileStreaming').mockImplementation(async resp => {
+      await resp;
+      return new WebAssembly.Module(EMPTY_WASM);
+    });
+  });
+
+  afterEach(() => {
+    vi.restoreAllMocks();
+    delete global.fetch;
+  });
+
+  it('should start fetching before the cache lookup answers', async () => {
+    const pending = compileQuireModule('quire.wasm', 'abc1234', storage);
+    // Synchronously, before any IDB request could have completed
+    expect(global.fetch).toHaveBeenCalledTimes(1);
+    expect(await pending).toBeInstanceOf(WebAssembly.Module);
+  });
+
+  it('should remember a failed store and skip IDB afterwards', async () => {
+    const open = vi.spyOn(indexedDB, 'open').mockImplementation(() => {
+      throw new Error('DataCloneError');
+    });
+    await compileQuireModule('quire.wasm', 'abc1234', storage);
+    await new Promise(r => setTimeout(r, 0));
+    expect(storage.getItem(MODULE_CACHE_OFF_KEY)).not.toBeNull();
+
+    open.mockClear();
+    expect(await compileQuireModule('quire.wasm', 'abc1234', storage))
+      .toBeInstanceOf(WebAssembly.Module);
+    expect(open).not.toHaveBeenCalled();
+  });
+
+  it('should never use IDB for dev builds', async () => {
+    const open = vi.spyOn(indexedDB, 'open');
+    await compileQuireModule('quire.wasm', 'dev', storage);
+    expect(open).not.toHaveBeenCalled();
+  });
+});